@@ -0,0 +1,194 @@
+#include "Betweenness.h"
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <random>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+using namespace std;
+
+Betweenness::Worker::Worker(int n) : sigma(n, 0), delta(n, 0), dist(n, -1), scores(n, 0) {
+    order.reserve(n);
+}
+
+Betweenness::Betweenness(const Graph& g) : n(g.numToVertex.size()), offsets(n + 1, 0) {
+    for (int v = 0; v < n; v++) {
+        offsets[v + 1] = offsets[v] + g.numToVertex[v].neighbors.size();
+    }
+    targets.reserve(offsets[n]);
+    for (int v = 0; v < n; v++) {
+        targets.insert(targets.end(), g.numToVertex[v].neighbors.begin(), g.numToVertex[v].neighbors.end());
+    }
+}
+
+/*
+ *  Brandes: BFS from s counting shortest paths, then walk the BFS order
+ *  backwards so every vertex's dependency is final before its parents
+ *  read it. Parents are found through out edges one level down, so no
+ *  predecessor lists are needed.
+ */
+void Betweenness::accumulate(int s, Worker& w) {
+    w.order.clear();
+    w.order.push_back(s);
+    w.dist[s] = 0;
+    w.sigma[s] = 1;
+
+    for (size_t head = 0; head < w.order.size(); head++) {
+        int v = w.order[head];
+        for (long long i = offsets[v]; i < offsets[v + 1]; i++) {
+            int t = targets[i];
+            if (w.dist[t] == -1) {
+                w.dist[t] = w.dist[v] + 1;
+                w.order.push_back(t);
+            }
+            if (w.dist[t] == w.dist[v] + 1) {
+                w.sigma[t] += w.sigma[v];
+            }
+        }
+    }
+
+    for (size_t k = w.order.size(); k-- > 0;) {
+        int v = w.order[k];
+        double dep = 0;
+        for (long long i = offsets[v]; i < offsets[v + 1]; i++) {
+            int t = targets[i];
+            if (w.dist[t] == w.dist[v] + 1) {
+                dep += w.sigma[v] / w.sigma[t] * (1 + w.delta[t]);
+            }
+        }
+        w.delta[v] = dep;
+        if (v != s) {
+            w.scores[v] += dep;
+        }
+    }
+
+    /* Only reset what this source touched */
+    for (int v : w.order) {
+        w.sigma[v] = 0;
+        w.delta[v] = 0;
+        w.dist[v] = -1;
+    }
+}
+
+void Betweenness::run(const vector<int>& sources, vector<Worker>& workers) {
+    atomic<size_t> next(0);
+    auto work = [&](Worker& w) {
+        size_t i;
+        while ((i = next++) < sources.size()) {
+            accumulate(sources[i], w);
+        }
+    };
+
+    vector<thread> pool;
+    for (size_t t = 1; t < workers.size(); t++) {
+        pool.push_back(thread(work, ref(workers[t])));
+    }
+    work(workers[0]);
+    for (thread& t : pool) {
+        t.join();
+    }
+    samples += sources.size();
+}
+
+vector<double> Betweenness::exact(unsigned threads) {
+    vector<Worker> workers(max(1u, threads), Worker(n));
+    vector<int> sources(n);
+    for (int v = 0; v < n; v++) {
+        sources[v] = v;
+    }
+    samples = 0;
+    bound = n;
+    run(sources, workers);
+
+    vector<double> scores(n, 0);
+    for (Worker& w : workers) {
+        for (int v = 0; v < n; v++) {
+            scores[v] += w.scores[v];
+        }
+    }
+    return scores;
+}
+
+vector<double> Betweenness::sampled(const SampleOptions& opts) {
+    if (!(opts.epsilon > 0) || !(opts.delta > 0 && opts.delta < 1)) {
+        std::cout << "Sampled betweenness needs epsilon > 0 and 0 < delta < 1" << std::endl;
+        abort();
+    }
+    samples = 0;
+    bound = 0;
+    if (n < 3) {
+        return vector<double>(n, 0); // no vertex can be strictly between two others
+    }
+
+    /* Hoeffding plus a union bound over all n vertices, on dependency / (n - 2) in [0, 1] */
+    size_t maxSamples = ceil(log(2.0 * n / opts.delta) / (2 * opts.epsilon * opts.epsilon));
+    bound = maxSamples;
+    vector<Worker> workers(max(1u, opts.threads), Worker(n));
+    mt19937 rng(opts.seed);
+    uniform_int_distribution<int> pick(0, n - 1);
+
+    vector<double> total(n, 0);
+    vector<int> lastTop;
+    vector<int> sources;
+    while (samples < maxSamples) {
+        sources.clear();
+        size_t count = min((size_t)max(1u, opts.batch), maxSamples - samples);
+        for (size_t i = 0; i < count; i++) {
+            sources.push_back(pick(rng));
+        }
+        run(sources, workers);
+
+        if (opts.adaptive <= 0 || samples >= maxSamples) {
+            continue;
+        }
+
+        /* Adaptive stop: the K-th best has enough dependency and the top K set is stable */
+        fill(total.begin(), total.end(), 0.0);
+        for (Worker& w : workers) {
+            for (int v = 0; v < n; v++) {
+                total[v] += w.scores[v];
+            }
+        }
+        vector<pair<int, double>> top = topK(total, opts.topK);
+        vector<int> topIds;
+        for (pair<int, double>& p : top) {
+            topIds.push_back(p.first);
+        }
+        sort(topIds.begin(), topIds.end());
+        bool enough = !top.empty() && top.back().second >= opts.adaptive * n;
+        if (enough && topIds == lastTop) {
+            break;
+        }
+        lastTop = topIds;
+    }
+
+    vector<double> scores(n, 0);
+    for (Worker& w : workers) {
+        for (int v = 0; v < n; v++) {
+            scores[v] += w.scores[v];
+        }
+    }
+    double scale = (double)n / samples;
+    for (double& s : scores) {
+        s *= scale;
+    }
+    return scores;
+}
+
+vector<pair<int, double>> Betweenness::topK(const vector<double>& scores, size_t k) {
+    vector<int> order(scores.size());
+    for (size_t v = 0; v < order.size(); v++) {
+        order[v] = v;
+    }
+    k = min(k, order.size());
+    partial_sort(order.begin(), order.begin() + k, order.end(), [&](int a, int b) {
+        return scores[a] > scores[b] || (scores[a] == scores[b] && a < b);
+    });
+
+    vector<pair<int, double>> top;
+    for (size_t i = 0; i < k; i++) {
+        top.push_back(make_pair(order[i], scores[order[i]]));
+    }
+    return top;
+}
@@ -0,0 +1,105 @@
+#pragma once
+#include "Graph.h"
+#include <vector>
+#include <utility>
+
+/*
+ * Options for sampled betweenness
+ * epsilon  - additive error bound on normalized betweenness (score divided
+ *            by (n - 1)(n - 2)), holding for every vertex at once
+ * delta    - the bound may fail with probability at most delta
+ * topK     - number of top vertices the adaptive stop watches
+ * adaptive - stop early once the topK-th largest score has gathered
+ *            adaptive * n dependency and the top K set stopped changing
+ *            between batches. 0 always runs the full epsilon/delta sample
+ * batch    - sources per batch, the stop rule is checked between batches
+ * threads  - worker threads
+ * seed     - source sampling seed
+ */
+struct SampleOptions {
+    double epsilon = 0.05;
+    double delta = 0.1;
+    unsigned topK = 10;
+    double adaptive = 5.0;
+    unsigned batch = 256;
+    unsigned threads = 4;
+    unsigned seed = 225;
+};
+
+/*
+ * Betweenness centrality (how many shortest paths go through each article)
+ * by Brandes' algorithm, with one BFS per source spread over threads.
+ * Scores are for the directed graph and are not normalized.
+ */
+class Betweenness {
+    public:
+        /*
+         * Copies the graph's out edges into flat arrays
+         */
+        Betweenness(const Graph& g);
+
+        /*
+         * Exact scores, one BFS from every vertex
+         */
+        std::vector<double> exact(unsigned threads);
+
+        /*
+         * Estimated scores from uniformly sampled sources, scaled up by
+         * n / samples. At most ln(2n / delta) / (2 epsilon^2) sources.
+         * The epsilon/delta guarantee only holds if the run did not stop
+         * early (see stoppedEarly). Aborts unless epsilon > 0 and
+         * 0 < delta < 1
+         */
+        std::vector<double> sampled(const SampleOptions& opts);
+
+        /*
+         * Sources used by the last call to exact() or sampled()
+         */
+        size_t samplesUsed() const { return samples; }
+
+        /*
+         * Sources the epsilon/delta bound called for in the last sampled()
+         */
+        size_t sampleBound() const { return bound; }
+
+        /*
+         * True if the last sampled() was ended by the adaptive rule before
+         * reaching sampleBound()
+         */
+        bool stoppedEarly() const { return samples < bound; }
+
+        /*
+         * The k highest scoring vertices, highest first
+         */
+        static std::vector<std::pair<int, double>> topK(const std::vector<double>& scores, size_t k);
+
+    private:
+        /*
+         * Per-thread scratch and running totals for that thread's sources
+         */
+        struct Worker {
+            std::vector<double> sigma;  // number of shortest paths from the source
+            std::vector<double> delta;  // dependency of the source on each vertex
+            std::vector<int> dist;      // -1 when not reached
+            std::vector<int> order;     // vertices in BFS order, walked backwards to accumulate
+            std::vector<double> scores; // summed dependencies
+
+            Worker(int n);
+        };
+
+        /*
+         * Runs every source in sources, split over the workers
+         */
+        void run(const std::vector<int>& sources, std::vector<Worker>& workers);
+
+        /*
+         * Single source shortest paths plus dependency accumulation
+         */
+        void accumulate(int s, Worker& w);
+
+        int n;
+        std::vector<long long> offsets; // out neighbors of v are targets[offsets[v] .. offsets[v+1])
+        std::vector<int> targets;
+        size_t samples = 0;
+        size_t bound = 0;
+};
@@ -0,0 +1,453 @@
+#include "ExternalGraph.h"
+#include <iostream>
+#include <fstream>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <cerrno>
+#include <cstdio>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+using namespace std;
+
+static const long long CSR_MAGIC = 0x31525343; // "CSR1"
+
+/*
+ *  pread until len bytes are in or the file ends, returns bytes read
+ */
+static size_t readAt(int fd, char* buf, size_t len, long long offset) {
+    size_t done = 0;
+    while (done < len) {
+        ssize_t r = pread(fd, buf + done, len - done, offset + done);
+        if (r < 0 && errno == EINTR) {
+            continue;
+        }
+        if (r <= 0) {
+            break;
+        }
+        done += r;
+    }
+    return done;
+}
+
+BlockReader::BlockReader(int f, long long begin, long long e, size_t bytes)
+    : fd(f), pos(begin), end(e), current(1), pendingBytes(0) {
+    blockBytes = max((size_t)4096, bytes - bytes % sizeof(int)); // blocks always hold whole ints
+    buffers[0].resize(blockBytes);
+    buffers[1].resize(blockBytes);
+    prefetch();
+}
+
+BlockReader::~BlockReader() {
+    if (pending.valid()) {
+        pending.wait();
+    }
+}
+
+void BlockReader::prefetch() {
+    if (pos >= end) {
+        return;
+    }
+    size_t len = min((long long)blockBytes, end - pos);
+    char* buf = buffers[1 - current].data();
+    long long offset = pos;
+    int file = fd;
+    pending = async(launch::async, [=]() { return readAt(file, buf, len, offset); });
+    pendingBytes = len;
+    pos += len;
+}
+
+size_t BlockReader::next(const char*& data) {
+    if (!pending.valid()) {
+        return 0;
+    }
+    size_t n = pending.get();
+    current = 1 - current;
+    if (n != pendingBytes) {
+        std::cout << "CSR file ended early, it may be truncated" << std::endl;
+        abort();
+    }
+    data = buffers[current].data();
+    prefetch(); // read the following block while the caller uses this one
+    return n;
+}
+
+/*
+ *  Parses a "tail head" line, false unless both are vertex ids below V
+ */
+static bool parseEdge(const std::string& line, long long V, int edge[2]) {
+    const char* start = line.c_str();
+    char* rest;
+    long tail = strtol(start, &rest, 10);
+    if (rest == start) {
+        return false;
+    }
+    start = rest;
+    long head = strtol(start, &rest, 10);
+    if (rest == start || tail < 0 || tail >= V || head < 0 || head >= V) {
+        return false;
+    }
+    edge[0] = tail;
+    edge[1] = head;
+    return true;
+}
+
+/*
+ *  Removes a partial build and stops, so a broken CSR file is never left behind
+ */
+static void failBuild(std::string message, const std::string& csrFile, int buckets) {
+    std::cout << message << std::endl;
+    for (int b = 0; b < buckets; b++) {
+        remove((csrFile + ".bucket" + to_string(b)).c_str());
+    }
+    remove((csrFile + ".tmp").c_str());
+    abort();
+}
+
+/*
+ *  File layout: magic, V, E (int64 each), V + 1 offsets (int64), E targets (int32)
+ */
+void ExternalGraph::buildCSR(string vertexFile, string edgeFile, string csrFile, size_t memoryEdges) {
+    std::ifstream fileVertex(vertexFile);
+    if (!fileVertex.good() || !std::ifstream(edgeFile).good()) {
+        std::cout << "File doesn't seem to exist. Double check your directory." << std::endl;
+        abort();
+    }
+    std::string line;
+    long long V = 0;
+    while (getline(fileVertex, line)) {
+        V++;
+    }
+
+    /* Pass 1: out degree of every vertex gives the offsets */
+    vector<long long> offsets(V + 1, 0);
+    {
+        std::ifstream fileEdge(edgeFile);
+        long long lineNum = 0;
+        int edge[2];
+        while (getline(fileEdge, line)) {
+            lineNum++;
+            if (line.empty()) {
+                continue;
+            }
+            if (!parseEdge(line, V, edge)) {
+                failBuild("Bad edge on line " + to_string(lineNum) + " of " + edgeFile + ": " + line, csrFile, 0);
+            }
+            offsets[edge[0] + 1]++;
+        }
+    }
+    for (long long v = 0; v < V; v++) {
+        offsets[v + 1] += offsets[v];
+    }
+    const long long E = offsets[V];
+
+    /* Split vertices into ranges holding at most memoryEdges edges each */
+    vector<long long> bucketStart(1, 0);
+    for (long long v = 0; v < V; v++) {
+        if (v > bucketStart.back() && offsets[v + 1] - offsets[bucketStart.back()] > (long long)memoryEdges) {
+            bucketStart.push_back(v);
+        }
+    }
+    bucketStart.push_back(V);
+    const int buckets = bucketStart.size() - 1;
+
+    /* Pass 2: append each edge to its tail's bucket file */
+    {
+        vector<std::ofstream> bucketFiles(buckets);
+        for (int b = 0; b < buckets; b++) {
+            bucketFiles[b].open(csrFile + ".bucket" + to_string(b), ios::binary);
+        }
+        std::ifstream fileEdge(edgeFile);
+        int edge[2];
+        while (getline(fileEdge, line)) {
+            if (line.empty()) {
+                continue;
+            }
+            if (!parseEdge(line, V, edge)) {
+                failBuild(edgeFile + " changed while building " + csrFile, csrFile, buckets);
+            }
+            int b = upper_bound(bucketStart.begin(), bucketStart.end(), edge[0]) - bucketStart.begin() - 1;
+            if (!bucketFiles[b].write((const char*)edge, sizeof(edge))) {
+                failBuild("Could not write temporary bucket file for " + csrFile, csrFile, buckets);
+            }
+        }
+        for (std::ofstream& f : bucketFiles) {
+            f.close();
+            if (!f) {
+                failBuild("Could not write temporary bucket file for " + csrFile, csrFile, buckets);
+            }
+        }
+    }
+
+    std::string tmpFile = csrFile + ".tmp";
+    std::ofstream out(tmpFile, ios::binary);
+    long long header[3] = {CSR_MAGIC, V, E};
+    out.write((const char*)header, sizeof(header));
+    out.write((const char*)offsets.data(), offsets.size() * sizeof(long long));
+    if (!out.good()) {
+        failBuild("Could not write " + tmpFile, csrFile, buckets);
+    }
+
+    /* Pass 3: counting sort each bucket by tail (stable, so file order is kept) */
+    for (int b = 0; b < buckets; b++) {
+        string name = csrFile + ".bucket" + to_string(b);
+        long long first = bucketStart[b];
+        long long base = offsets[first];
+        vector<int> targets(offsets[bucketStart[b + 1]] - base);
+        vector<long long> fill(offsets.begin() + first, offsets.begin() + bucketStart[b + 1]);
+
+        std::ifstream in(name, ios::binary);
+        int edge[2];
+        long long read = 0;
+        while (in.read((char*)edge, sizeof(edge))) {
+            if (edge[0] < first || edge[0] >= bucketStart[b + 1] || fill[edge[0] - first] >= offsets[edge[0] + 1]) {
+                failBuild("Temporary bucket file for " + csrFile + " is corrupt", csrFile, buckets);
+            }
+            targets[fill[edge[0] - first]++ - base] = edge[1];
+            read++;
+        }
+        in.close();
+        if (read != (long long)targets.size()) {
+            failBuild("Temporary bucket file for " + csrFile + " is incomplete", csrFile, buckets);
+        }
+        remove(name.c_str());
+        out.write((const char*)targets.data(), targets.size() * sizeof(int));
+        if (!out.good()) {
+            failBuild("Could not write " + tmpFile, csrFile, buckets);
+        }
+    }
+
+    /* Only a complete file ever shows up under csrFile */
+    out.close();
+    if (!out || rename(tmpFile.c_str(), csrFile.c_str()) != 0) {
+        failBuild("Could not finish " + csrFile, csrFile, 0);
+    }
+}
+
+ExternalGraph::ExternalGraph(string csrFile, size_t bytes) : blockBytes(bytes) {
+    fd = open(csrFile.c_str(), O_RDONLY);
+    long long header[3];
+    if (fd < 0 || readAt(fd, (char*)header, sizeof(header), 0) != sizeof(header) || header[0] != CSR_MAGIC) {
+        std::cout << "Not a CSR file: " << csrFile << std::endl;
+        abort();
+    }
+    V = header[1];
+    E = header[2];
+
+    /* A build that was cut short leaves a file smaller than its header says */
+    struct stat info;
+    bool sane = header[1] >= 0 && header[1] < (1LL << 31) && E >= 0 && fstat(fd, &info) == 0;
+    targetsStart = sane ? sizeof(header) + (header[1] + 1) * sizeof(long long) : 0;
+    if (!sane || info.st_size != targetsStart + E * (long long)sizeof(int)) {
+        std::cout << "CSR file " << csrFile << " is incomplete or corrupt, delete it and rebuild" << std::endl;
+        abort();
+    }
+    offsets.resize(V + 1);
+    readAt(fd, (char*)offsets.data(), offsets.size() * sizeof(long long), sizeof(header));
+    for (int v = 0; v < V; v++) {
+        sane = sane && offsets[v] <= offsets[v + 1];
+    }
+    if (!sane || offsets[0] != 0 || offsets[V] != E) {
+        std::cout << "CSR file " << csrFile << " has bad offsets, delete it and rebuild" << std::endl;
+        abort();
+    }
+    posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+}
+
+ExternalGraph::~ExternalGraph() {
+    close(fd);
+}
+
+void ExternalGraph::scanEdges(const function<void(int, const int*, size_t, long long)>& visit) {
+    BlockReader reader(fd, targetsStart, targetsStart + E * sizeof(int), blockBytes);
+    const char* data;
+    size_t n;
+    int u = 0;
+    long long e = 0; // index of the next edge
+    while ((n = reader.next(data)) > 0) {
+        const int* t = (const int*)data;
+        size_t count = n / sizeof(int);
+        size_t i = 0;
+        while (i < count) {
+            while (offsets[u + 1] <= e) {
+                u++; // skip vertices with no edges left
+            }
+            size_t run = min((long long)(count - i), offsets[u + 1] - e);
+            visit(u, t + i, run, e - offsets[u]);
+            i += run;
+            e += run;
+        }
+    }
+}
+
+void ExternalGraph::readNeighbors(int v, vector<int>& out) {
+    out.resize(degree(v));
+    size_t bytes = out.size() * sizeof(int);
+    if (readAt(fd, (char*)out.data(), bytes, targetsStart + offsets[v] * sizeof(int)) != bytes) {
+        std::cout << "CSR file ended early, it may be truncated" << std::endl;
+        abort();
+    }
+}
+
+/*
+ *  Level synchronous, with the same tie break as PartitionedGraph::BFS:
+ *  every frontier vertex has its position in Graph::BFS's queue (rank), and a
+ *  vertex reached more than once in a level keeps the smallest
+ *  (parent rank, edge index). While v waits in next, rank[v] holds that key.
+ */
+vector<int> ExternalGraph::BFS(int search_id, int start_id) {
+    if (start_id < 0 || start_id >= V) {
+        return vector<int>(1, -1);
+    }
+    if (search_id == start_id) {
+        return vector<int>(1, start_id);
+    }
+
+    vector<int> parent(V, -1);
+    vector<int> rank(V, 0);
+    vector<int> bestEdge(V, 0);
+    vector<bool> inFrontier(V, false), inNext(V, false);
+    vector<int> frontier(1, start_id), next, adj;
+    parent[start_id] = start_id;
+
+    auto reached = [&]() {
+        return search_id >= 0 && search_id < V && parent[search_id] != -1;
+    };
+    auto candidate = [&](int u, int v, int e) {
+        if (parent[v] == -1) {
+            parent[v] = u;
+            rank[v] = rank[u];
+            bestEdge[v] = e;
+            inNext[v] = true;
+            next.push_back(v);
+        } else if (inNext[v] && make_pair(rank[u], e) < make_pair(rank[v], bestEdge[v])) {
+            parent[v] = u;
+            rank[v] = rank[u];
+            bestEdge[v] = e;
+        }
+    };
+
+    while (!frontier.empty() && !reached()) {
+        long long frontierEdges = 0;
+        for (int u : frontier) {
+            frontierEdges += degree(u);
+        }
+
+        next.clear();
+        if (frontierEdges < E / 16) {
+            /* Few edges to look at: seek to each frontier vertex, in file order */
+            vector<int> sorted(frontier);
+            sort(sorted.begin(), sorted.end());
+            for (int u : sorted) {
+                readNeighbors(u, adj);
+                for (size_t j = 0; j < adj.size(); j++) {
+                    candidate(u, adj[j], j);
+                }
+            }
+        } else {
+            /* Most of the graph is involved: one sequential pass over every edge */
+            for (int u : frontier) {
+                inFrontier[u] = true;
+            }
+            scanEdges([&](int u, const int* t, size_t count, long long first) {
+                if (inFrontier[u]) {
+                    for (size_t j = 0; j < count; j++) {
+                        candidate(u, t[j], first + j);
+                    }
+                }
+            });
+            for (int u : frontier) {
+                inFrontier[u] = false;
+            }
+        }
+
+        /* Order the new level the way Graph::BFS would have queued it */
+        sort(next.begin(), next.end(), [&](int a, int b) {
+            return make_pair(rank[a], bestEdge[a]) < make_pair(rank[b], bestEdge[b]);
+        });
+        for (size_t i = 0; i < next.size(); i++) {
+            rank[next[i]] = i;
+            inNext[next[i]] = false;
+        }
+        frontier.swap(next);
+    }
+
+    if (!reached()) {
+        return vector<int>(1, -1);
+    }
+    vector<int> path;
+    for (int v = search_id; v != start_id; v = parent[v]) {
+        path.push_back(v);
+    }
+    path.push_back(start_id);
+    reverse(path.begin(), path.end());
+    return path;
+}
+
+vector<int> ExternalGraph::weakComponents() {
+    vector<int> comp(V);
+    for (int v = 0; v < V; v++) {
+        comp[v] = v;
+    }
+
+    /* Union-find with path halving, the smaller root always wins */
+    auto find = [&](int v) {
+        while (comp[v] != v) {
+            comp[v] = comp[comp[v]];
+            v = comp[v];
+        }
+        return v;
+    };
+    scanEdges([&](int u, const int* t, size_t count, long long) {
+        for (size_t j = 0; j < count; j++) {
+            int a = find(u);
+            int b = find(t[j]);
+            if (a < b) {
+                comp[b] = a;
+            } else if (b < a) {
+                comp[a] = b;
+            }
+        }
+    });
+
+    for (int v = 0; v < V; v++) {
+        comp[v] = find(v);
+    }
+    return comp;
+}
+
+vector<double> ExternalGraph::pageRank(int iterations, double damping, double tolerance) {
+    vector<double> rank(V, 1.0 / V);
+    vector<double> next(V);
+
+    for (int it = 0; it < iterations; it++) {
+        double dangling = 0;
+        for (int v = 0; v < V; v++) {
+            if (degree(v) == 0) {
+                dangling += rank[v];
+            }
+        }
+        fill(next.begin(), next.end(), 0.0);
+
+        scanEdges([&](int u, const int* t, size_t count, long long) {
+            double share = rank[u] / degree(u);
+            for (size_t j = 0; j < count; j++) {
+                next[t[j]] += share;
+            }
+        });
+
+        double base = (1 - damping) / V + damping * dangling / V;
+        double change = 0;
+        for (int v = 0; v < V; v++) {
+            next[v] = base + damping * next[v];
+            change += fabs(next[v] - rank[v]);
+        }
+        rank.swap(next);
+        if (change < tolerance) {
+            break;
+        }
+    }
+    return rank;
+}
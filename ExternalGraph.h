@@ -0,0 +1,103 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <functional>
+#include <future>
+
+/*
+ * Reads a byte range of a file in large blocks, fetching the next block on
+ * a background thread while the caller works on the current one
+ */
+class BlockReader {
+    public:
+        BlockReader(int fd, long long begin, long long end, size_t blockBytes);
+        ~BlockReader();
+
+        /*
+         * Points data at the next block and returns its size, 0 at the end.
+         * Aborts if the file is shorter than the range it was given
+         */
+        size_t next(const char*& data);
+
+    private:
+        void prefetch();
+
+        int fd;
+        long long pos;  // file offset of the next block to request
+        long long end;
+        size_t blockBytes;
+        std::vector<char> buffers[2];
+        int current;    // buffer handed out by the last next()
+        std::future<size_t> pending;
+        size_t pendingBytes; // size of the block pending is reading
+};
+
+/*
+ * Semi-external link graph for dumps too big for Graph. Adjacency stays on
+ * disk as a binary CSR file (see buildCSR) and is streamed sequentially;
+ * only per-vertex state (offsets, visited bits, parents, labels) is kept
+ * in memory.
+ */
+class ExternalGraph {
+    public:
+        /*
+         * Converts a vertex file and "tail head" edge file into a binary CSR
+         * file. Edges are bucketed by tail into temporary files so at most
+         * memoryEdges edges are in memory at once. Neighbor order matches
+         * the edge file, same as Graph::parseEdges. The file is written to
+         * csrFile + ".tmp" and only renamed to csrFile once it is complete
+         */
+        static void buildCSR(std::string vertexFile, std::string edgeFile, std::string csrFile,
+                             size_t memoryEdges = 1 << 26);
+
+        /*
+         * Opens a CSR file written by buildCSR, loading only its offsets.
+         * Aborts if the header, offsets or file size don't add up
+         */
+        ExternalGraph(std::string csrFile, size_t blockBytes = 8 << 20);
+        ~ExternalGraph();
+
+        /*
+         * Same path as Graph::BFS, {-1} if search_id can't be reached.
+         * Each level either seeks to the adjacency of the frontier (small
+         * frontiers) or streams the whole edge file (large ones)
+         */
+        std::vector<int> BFS(int search_id, int start_id = 0);
+
+        /*
+         * Weakly connected components in one pass over the edges, using
+         * union-find. Entry v is the smallest vertex id in v's component
+         */
+        std::vector<int> weakComponents();
+
+        /*
+         * PageRank by streaming the edges once per iteration. Rank of
+         * dangling articles is spread evenly. Stops early once the total
+         * change in an iteration drops below tolerance
+         */
+        std::vector<double> pageRank(int iterations = 20, double damping = 0.85, double tolerance = 1e-9);
+
+        int numVertices() const { return V; }
+        long long numEdges() const { return E; }
+        int degree(int v) const { return offsets[v + 1] - offsets[v]; }
+
+    private:
+        /*
+         * Streams every edge in tail order. visit gets a tail vertex, a run
+         * of its targets, the run length, and the index of the run's first
+         * target in the tail's neighbor list (runs can split across blocks)
+         */
+        void scanEdges(const std::function<void(int, const int*, size_t, long long)>& visit);
+
+        /*
+         * Reads the neighbors of one vertex with a single positioned read
+         */
+        void readNeighbors(int v, std::vector<int>& out);
+
+        int fd;
+        int V;
+        long long E;
+        std::vector<long long> offsets; // neighbors of v are targets[offsets[v] .. offsets[v+1])
+        long long targetsStart;         // byte offset of the targets array in the file
+        size_t blockBytes;
+};
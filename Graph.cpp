@@ -48,6 +48,7 @@ void Graph::parseVertices(std::string filename){
         numToVertex.push_back(Vertex(line.substr(line.find(" ") + 1), parsed_ct)); // new Vertex constructor, name and id
         parsed_ct++;
     }
+    bumpVersion();
 }
 
 /*
@@ -86,6 +87,7 @@ void Graph::parseEdges(std::string filename){
         numToVertex[headVertex].in_neighbors.push_back(tailVertex);
         parsed_ct++;
     }
+    bumpVersion();
 }
 
 /*
@@ -177,14 +179,54 @@ void Graph::printNumToName() {
     }
 }
 
-std::list<int> Graph::list_neighbors(int v) {
+const std::list<int>& Graph::list_neighbors(int v) {
     return numToVertex[v].neighbors;
 }
-std::list<int> Graph::list_categories(int v) {
+const std::list<int>& Graph::list_categories(int v) {
     return numToVertex[v].categories;
 }
 
 vector<int> Graph::BFS(int search_id, int start_id) {
+    /* Check for a cached BFS tree for start_id first, then cached results. Each
+       request counts once: as a tree hit, a hit, or a miss */
+    QueryKey key{QueryType::PATH, start_id, search_id, 0};
+    vector<int> cached;
+    if (cache.lookupTree(start_id, search_id, version, cached) || cache.lookup(key, version, cached)) {
+        return cached;
+    }
+
+    /* start_id is popular, cache its whole BFS tree and answer from that */
+    if (cache.noteMiss(start_id)) {
+        vector<int> parents = bfsTree(start_id);
+        cache.insertTree(start_id, version, parents);
+        return ResultCache::pathFromTree(parents, start_id, search_id);
+    }
+
+    vector<int> path = BFSPath(search_id, start_id);
+    cache.insert(key, version, path);
+    return path;
+}
+
+vector<int> Graph::bfsTree(int start_id) {
+    vector<int> parents(numToVertex.size(), -1);
+    queue<int> q;
+
+    parents[start_id] = start_id;
+    q.push(start_id);
+    while (!q.empty()) {
+        int v_id = q.front();
+        q.pop();
+        for (int n : numToVertex[v_id].neighbors) {
+            if (parents[n] == -1) {
+                parents[n] = v_id;
+                q.push(n);
+            }
+        }
+    }
+    return parents;
+}
+
+vector<int> Graph::BFSPath(int search_id, int start_id) {
     queue<vector<int>> q;
     unordered_map<int, bool> discovered;
 
@@ -213,8 +255,36 @@ vector<int> Graph::BFS(int search_id, int start_id) {
 }
 
 void Graph::findCycle(int start_id){
-    // Cycle Detection with motified BFS
     std::cout << "Finding Cycle for chosen article..." << std::endl;
+    vector<int> curr_path = cyclePath(start_id);
+
+    bool found = !curr_path.empty();
+    int size_of_cycle = curr_path.size() - 1; // size of cycle path
+    int arrows = size_of_cycle;
+
+    if(found){ // if cycle found, print cycle with size
+        std::cout << "Size of Cycle Path: " << size_of_cycle << std::endl;
+        for (int v : curr_path) {
+            std::cout << v << " " << numToVertex[v].name;
+            if(arrows > 0){std::cout << " -> ";} // arrows for graph visual
+            arrows--;
+        }
+        std::cout << std::endl;
+    }
+    else{
+        std::cout << "Sorry, Cycle does not Exist!" << std::endl;
+    }
+    
+}
+
+vector<int> Graph::cyclePath(int start_id){
+    QueryKey key{QueryType::CYCLE, start_id, start_id, 0};
+    vector<int> cached;
+    if (cache.lookup(key, version, cached)) {
+        return cached;
+    }
+
+    // Cycle Detection with motified BFS
     queue<vector<int>> q;
     unordered_map<int, bool> discovered;
 
@@ -249,27 +319,17 @@ void Graph::findCycle(int start_id){
 
     if (v_id == start_id){found = true;} // mark cycle indicator true
 
-    int size_of_cycle = curr_path.size() - 1; // size of cycle path
-    int arrows = size_of_cycle;
-
-    if(found){ // if cycle found, print cycle with size
-        std::cout << "Size of Cycle Path: " << size_of_cycle << std::endl;
-        for (int v : curr_path) {
-            std::cout << v << " " << numToVertex[v].name;
-            if(arrows > 0){std::cout << " -> ";} // arrows for graph visual
-            arrows--;
-        }
-        std::cout << std::endl;
-    }
-    else{
-        std::cout << "Sorry, Cycle does not Exist!" << std::endl;
+    if(!found){
+        curr_path.clear();
     }
-    
+    cache.insert(key, version, curr_path);
+    return curr_path;
 }
 
 unordered_map<int, list<int>> Graph::KosarajuSCC() {
     // KOSARAJU's ALGORITHM
     std::cout << "Starting Kosaraju's algorithm" << std::endl;
+    components.clear();
     std::cout << "Visiting all nodes..." << std::endl;
     for (unsigned v_id = 0 ; v_id < numToVertex.size(); v_id++) {
         visit(v_id);
@@ -301,23 +361,24 @@ unordered_map<int, list<int>> Graph::KosarajuSCC() {
 
 void Graph::visit(int v_id) {
     if (numToVertex[v_id].visited == false) {
-        std::stack<int> to_visit; // uses DFS to visit all possible neighbors of each node.
-        to_visit.push(v_id);
-        std::unordered_map<int, bool> seen;
+        // uses DFS to visit all possible neighbors of each node. Each stack entry keeps its place
+        // in the neighbor list so a node is only finished after everything below it is
+        std::stack<std::pair<int, std::list<int>::iterator>> to_visit;
+        numToVertex[v_id].visited = true;
+        to_visit.push(std::make_pair(v_id, numToVertex[v_id].neighbors.begin()));
         while (!to_visit.empty()) {
-            int t_id = to_visit.top();
-            to_visit.pop();
-            numToVertex[t_id].visited = true;
-            if (!seen[t_id]) {
-                to_visit.push(t_id);
-                seen[t_id] = true;
-            } else {
+            int t_id = to_visit.top().first;
+            std::list<int>::iterator& it = to_visit.top().second;
+            if (it == numToVertex[t_id].neighbors.end()) {
                 finished.push(t_id);
+                to_visit.pop();
+                continue;
             }
-            for (int n_id : numToVertex[t_id].neighbors) {
-                if (!numToVertex[n_id].visited) {
-                    to_visit.push(n_id);
-                }
+            int n_id = *it;
+            it++;
+            if (!numToVertex[n_id].visited) {
+                numToVertex[n_id].visited = true;
+                to_visit.push(std::make_pair(n_id, numToVertex[n_id].neighbors.begin()));
             }
         }
     }
@@ -364,8 +425,10 @@ unsigned Graph::linesInFile(std::string filename){
 bool Graph::fileExists(std::string filename){
     ifstream f(filename);
     return f.good();
-<<<<<<< HEAD
 }
-=======
+
+void Graph::bumpVersion() {
+    version++;
+    cache.clear();
 }
->>>>>>> 623fa989864b3515018b8fbd3b49dbdcfc1135bb
+
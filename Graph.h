@@ -1,4 +1,6 @@
+#pragma once
 #include "Vertex.h"
+#include "ResultCache.h"
 #include <iostream>
 #include <vector>
 #include "unordered_map"
@@ -28,6 +30,11 @@ class Graph {
          */
         bool fileExists(std::string filename);
 
+        /*
+         * Uncached BFS path search, used by BFS() on a cache miss
+         */
+        std::vector<int> BFSPath(int search_id, int start_id);
+
     public:
         // these two vectors are for file reading purposes
         std::vector<Vertex> numToVertex; // i = 0 gives vertex, which can tell you name, neighbors, etc..
@@ -93,13 +100,14 @@ class Graph {
 
         /*
          * neighbors for each vertex (connected articles)
+         * for more than one hop see Neighborhood.h
          */
-        std::list<int> list_neighbors(int v); 
+        const std::list<int>& list_neighbors(int v); 
 
         /*
          * categories that each article may be in
          */
-        std::list<int> list_categories(int v);
+        const std::list<int>& list_categories(int v);
 
         /*
          * BFS, searches for Vertex id, optional second argument for the id
@@ -107,6 +115,13 @@ class Graph {
          */
         std::vector<int> BFS(int search_id, int start_id = 0); 
 
+        /*
+         * Full BFS from start_id, returns the parent of every vertex in the
+         * BFS tree (start_id is its own parent, -1 for unreached vertices).
+         * Neighbors are visited in the same order as BFS() so paths match
+         */
+        std::vector<int> bfsTree(int start_id);
+
         /*
          * finds all strongly connected components of the graph,
          * returns them in a map of lists each representing a component
@@ -128,6 +143,24 @@ class Graph {
         */
         void findCycle(int start_id);
 
+        /*
+         * Computes the cycle printed by findCycle, empty if there is none
+         */
+        std::vector<int> cyclePath(int start_id);
+
+        /*
+         * Version of the graph data, bumped by every parse. Cached results
+         * from an older version are ignored. Call bumpVersion() after
+         * editing numToVertex directly
+         */
+        unsigned long version = 0;
+        void bumpVersion();
+
+        /*
+         * Cache for BFS() and findCycle() results
+         */
+        ResultCache cache;
+
         int visited_ct = 0;
 
         /*
@@ -0,0 +1,154 @@
+#include "Neighborhood.h"
+#include <algorithm>
+#include <thread>
+#include <mutex>
+#include <atomic>
+using namespace std;
+
+Neighborhood::Neighborhood(const Graph& graph)
+    : g(graph), stamp(graph.numToVertex.size(), 0), local(graph.numToVertex.size(), -1), epoch(0) {
+}
+
+vector<int> Neighborhood::kHop(int center, const HopOptions& opts) {
+    vector<int> members;
+    expand(center, opts, members);
+    members.erase(members.begin()); // drop the center
+    return members;
+}
+
+CSRSlice Neighborhood::egoNetwork(int center, const HopOptions& opts) {
+    CSRSlice slice;
+    expand(center, opts, slice.vertices);
+
+    slice.offsets.reserve(slice.vertices.size() + 1);
+    slice.offsets.push_back(0);
+    for (int v : slice.vertices) {
+        for (int n : g.numToVertex[v].neighbors) {
+            if (isMember(n)) {
+                slice.targets.push_back(local[n]);
+            }
+        }
+        slice.offsets.push_back(slice.targets.size());
+    }
+    return slice;
+}
+
+void Neighborhood::streamEgoNetwork(int center, const HopOptions& opts, const EdgeWriter& writer) {
+    vector<int> members;
+    expand(center, opts, members);
+
+    for (int v : members) {
+        for (int n : g.numToVertex[v].neighbors) {
+            if (isMember(n)) {
+                writer(v, n);
+            }
+        }
+    }
+}
+
+void Neighborhood::expand(int center, const HopOptions& opts, vector<int>& members) {
+    /* New epoch clears every mark at once, reset for real only on wraparound */
+    epoch++;
+    if (epoch == 0) {
+        fill(stamp.begin(), stamp.end(), 0);
+        epoch = 1;
+    }
+    rng.seed(opts.seed ^ (unsigned)center);
+
+    members.clear();
+    members.push_back(center);
+    stamp[center] = epoch;
+    local[center] = 0;
+
+    /* Level by level BFS, members[begin, end) is the current frontier */
+    size_t begin = 0;
+    vector<int> picked;
+    for (int hop = 0; hop < opts.k && begin < members.size(); hop++) {
+        size_t end = members.size();
+        for (size_t i = begin; i < end; i++) {
+            picked.clear();
+            pickNeighbors(members[i], opts, picked);
+            for (int n : picked) {
+                if (!isMember(n)) {
+                    stamp[n] = epoch;
+                    local[n] = members.size();
+                    members.push_back(n);
+                }
+            }
+        }
+        begin = end;
+    }
+}
+
+void Neighborhood::pickNeighbors(int v, const HopOptions& opts, vector<int>& out) {
+    const Vertex& vert = g.numToVertex[v];
+    unsigned seen = 0;
+
+    /* Keeps the first fanout neighbors, or a uniform sample of them (reservoir sampling) */
+    auto offer = [&](int n) {
+        if (opts.fanout == 0 || seen < opts.fanout) {
+            out.push_back(n);
+        } else if (opts.sample) {
+            uniform_int_distribution<unsigned> dist(0, seen);
+            unsigned j = dist(rng);
+            if (j < opts.fanout) {
+                out[j] = n;
+            }
+        }
+        seen++;
+    };
+
+    if (opts.dir != Direction::IN) {
+        for (int n : vert.neighbors) {
+            offer(n);
+            if (!opts.sample && opts.fanout != 0 && seen >= opts.fanout) {
+                return;
+            }
+        }
+    }
+    if (opts.dir != Direction::OUT) {
+        for (int n : vert.in_neighbors) {
+            offer(n);
+            if (!opts.sample && opts.fanout != 0 && seen >= opts.fanout) {
+                return;
+            }
+        }
+    }
+}
+
+vector<CSRSlice> Neighborhood::batchEgoNetworks(const Graph& graph, const vector<int>& centers,
+                                                const HopOptions& opts, unsigned threads) {
+    vector<CSRSlice> slices(centers.size());
+    batchStream(graph, centers, opts, threads, [&](int i, const CSRSlice& slice) {
+        slices[i] = slice;
+    });
+    return slices;
+}
+
+void Neighborhood::batchStream(const Graph& graph, const vector<int>& centers, const HopOptions& opts,
+                               unsigned threads, const function<void(int, const CSRSlice&)>& sink) {
+    if (threads == 0) {
+        threads = 1;
+    }
+    atomic<size_t> next(0);
+    mutex sinkLock;
+
+    auto work = [&]() {
+        Neighborhood n(graph);
+        size_t i;
+        while ((i = next++) < centers.size()) {
+            CSRSlice slice = n.egoNetwork(centers[i], opts);
+            lock_guard<mutex> guard(sinkLock);
+            sink(i, slice);
+        }
+    };
+
+    vector<thread> pool;
+    for (unsigned t = 1; t < threads; t++) {
+        pool.push_back(thread(work));
+    }
+    work(); // the calling thread does its share too
+    for (thread& t : pool) {
+        t.join();
+    }
+}
@@ -0,0 +1,108 @@
+#pragma once
+#include "Graph.h"
+#include <vector>
+#include <functional>
+#include <random>
+
+/*
+ * Which edges a k-hop expansion follows
+ */
+enum class Direction { OUT, IN, BOTH };
+
+/*
+ * Options for k-hop expansion
+ * k       - number of hops from the center
+ * dir     - follow out edges, in edges, or both
+ * fanout  - max neighbors expanded per vertex, 0 for no limit
+ * sample  - when a vertex has more than fanout neighbors, pick a uniform
+ *           random subset instead of the first fanout
+ * seed    - sampling seed, mixed with the center id so results don't
+ *           depend on which thread handled the center
+ */
+struct HopOptions {
+    int k = 1;
+    Direction dir = Direction::OUT;
+    unsigned fanout = 0;
+    bool sample = false;
+    unsigned seed = 225;
+};
+
+/*
+ * Induced subgraph stored as a compressed sparse row slice.
+ * vertices[i] is the graph id of local vertex i (the center is local 0),
+ * the out edges of local vertex i are targets[offsets[i] .. offsets[i+1])
+ * given as local ids
+ */
+struct CSRSlice {
+    std::vector<int> vertices;
+    std::vector<int> offsets;
+    std::vector<int> targets;
+};
+
+/*
+ * Callback receiving one edge (tail, head) in graph ids
+ */
+typedef std::function<void(int, int)> EdgeWriter;
+
+/*
+ * k-hop neighborhood and ego-network extraction over a Graph.
+ * Keeps O(V) scratch arrays that are reused between calls, so one
+ * Neighborhood should be used by one thread at a time.
+ */
+class Neighborhood {
+    public:
+        Neighborhood(const Graph& graph);
+
+        /*
+         * Vertices within opts.k hops of center (not including center),
+         * in BFS order
+         */
+        std::vector<int> kHop(int center, const HopOptions& opts);
+
+        /*
+         * Subgraph induced by center and its k-hop neighborhood. Edges are
+         * the graph's out edges between members, whatever opts.dir is
+         */
+        CSRSlice egoNetwork(int center, const HopOptions& opts);
+
+        /*
+         * Same edges as egoNetwork, passed to writer one at a time instead
+         * of being stored. Only the member set is held in memory
+         */
+        void streamEgoNetwork(int center, const HopOptions& opts, const EdgeWriter& writer);
+
+        /*
+         * Extracts the ego-network of every center using the given number
+         * of threads. Result i belongs to centers[i]
+         */
+        static std::vector<CSRSlice> batchEgoNetworks(const Graph& graph, const std::vector<int>& centers,
+                                                      const HopOptions& opts, unsigned threads);
+
+        /*
+         * Like batchEgoNetworks, but hands each slice to sink as soon as it is
+         * built instead of keeping them all. sink calls are serialized but
+         * arrive in no particular order
+         */
+        static void batchStream(const Graph& graph, const std::vector<int>& centers, const HopOptions& opts,
+                                unsigned threads, const std::function<void(int, const CSRSlice&)>& sink);
+
+    private:
+        /*
+         * Fills members with center followed by its k-hop neighborhood and
+         * gives each member its local id
+         */
+        void expand(int center, const HopOptions& opts, std::vector<int>& members);
+
+        /*
+         * Appends the neighbors of v to be expanded (after fanout/sampling)
+         */
+        void pickNeighbors(int v, const HopOptions& opts, std::vector<int>& out);
+
+        bool isMember(int v) const { return stamp[v] == epoch; }
+
+        const Graph& g;
+        std::vector<unsigned> stamp; // stamp[v] == epoch marks v as a member of the current expansion
+        std::vector<int> local;      // local id of each member
+        unsigned epoch;
+        std::mt19937 rng;
+};
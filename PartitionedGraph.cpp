@@ -0,0 +1,492 @@
+#include "PartitionedGraph.h"
+#include <iostream>
+#include <fstream>
+#include <algorithm>
+#include <tuple>
+#include <cstdlib>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+using namespace std;
+
+/* Commands sent from the Cluster to its workers */
+static const int CMD_QUIT = 0;
+static const int CMD_BFS = 1;
+static const int CMD_SCC = 2;
+
+/* Level status worker 0 hands back during BFS */
+static const int BFS_CONTINUE = 0;
+static const int BFS_FOUND = 1;
+static const int BFS_EXHAUSTED = 2;
+
+PartitionedGraph::PartitionedGraph(Transport& transport, Partitioning p, string vertexFile, string edgeFile)
+    : t(transport), part(p), total(0), rangeStart(0) {
+    std::ifstream fileVertex(vertexFile);
+    std::ifstream fileEdge(edgeFile);
+    if (!fileVertex.good() || !fileEdge.good()) {
+        std::cout << "File doesn't seem to exist. Double check your directory." << std::endl;
+        abort();
+    }
+
+    /* Vertex ids are line numbers, only the count is needed */
+    std::string line;
+    while (getline(fileVertex, line)) {
+        total++;
+    }
+
+    const int n = t.size();
+    if (part == Partitioning::RANGE) {
+        int block = max(1, (total + n - 1) / n);
+        rangeStart = min(total, t.rank() * block);
+        numOwned = min(total, rangeStart + block) - rangeStart;
+    } else {
+        numOwned = total / n + (t.rank() < total % n ? 1 : 0);
+    }
+    out.resize(numOwned);
+    in.resize(numOwned);
+
+    /* Same format and edge order as Graph::parseEdges, so neighbor lists match */
+    while (getline(fileEdge, line)) {
+        int indexSpace = line.find(" ");
+        int tailVertex = std::stoi(line.substr(0, indexSpace));
+        int headVertex = std::stoi(line.substr(indexSpace));
+
+        if (owner(tailVertex) == t.rank()) {
+            out[localIndex(tailVertex)].push_back(headVertex);
+        }
+        if (owner(headVertex) == t.rank()) {
+            in[localIndex(headVertex)].push_back(tailVertex);
+        }
+    }
+    outbox.resize(n);
+    inbox.resize(n);
+}
+
+int PartitionedGraph::owner(int v) const {
+    if (part == Partitioning::RANGE) {
+        int block = max(1, (total + t.size() - 1) / t.size());
+        return v / block;
+    }
+    return v % t.size();
+}
+
+int PartitionedGraph::localIndex(int v) const {
+    if (part == Partitioning::RANGE) {
+        return v - rangeStart;
+    }
+    return v / t.size();
+}
+
+int PartitionedGraph::globalId(int i) const {
+    if (part == Partitioning::RANGE) {
+        return rangeStart + i;
+    }
+    return i * t.size() + t.rank();
+}
+
+int PartitionedGraph::sumAll(int x) {
+    for (int p = 0; p < t.size(); p++) {
+        outbox[p].push_back(x);
+    }
+    t.exchange(outbox, inbox);
+    int sum = 0;
+    for (int p = 0; p < t.size(); p++) {
+        sum += inbox[p][0];
+    }
+    return sum;
+}
+
+/*
+ *  Graph::BFS hands each vertex to the first frontier vertex (in queue
+ *  order) that reaches it. To reproduce that, every frontier vertex carries
+ *  its position in the sequential queue (its rank). A vertex reached from
+ *  several places in one level keeps the smallest (parent rank, edge index),
+ *  and worker 0 sorts those keys to hand out ranks for the next level.
+ */
+vector<int> PartitionedGraph::BFS(int search_id, int start_id) {
+    const int n = t.size();
+    const int me = t.rank();
+    if (start_id < 0 || start_id >= total) {
+        return vector<int>(1, -1);
+    }
+
+    vector<int> parent(numOwned, -1);
+    vector<int> level(numOwned, -1);
+    vector<int> bestRank(numOwned), bestEdge(numOwned);
+    vector<int> frontier, frontierRank, next;
+
+    if (owner(start_id) == me) {
+        parent[localIndex(start_id)] = start_id;
+        level[localIndex(start_id)] = 0;
+        frontier.push_back(localIndex(start_id));
+        frontierRank.push_back(0);
+    }
+
+    int status = search_id == start_id ? BFS_FOUND : BFS_CONTINUE;
+    for (int depth = 1; status == BFS_CONTINUE; depth++) {
+        /* Batch every edge leaving the frontier by owner: (vertex, parent, parent rank, edge index) */
+        for (size_t k = 0; k < frontier.size(); k++) {
+            int u = globalId(frontier[k]);
+            int idx = 0;
+            for (int v : out[frontier[k]]) {
+                vector<int>& msg = outbox[owner(v)];
+                msg.push_back(v);
+                msg.push_back(u);
+                msg.push_back(frontierRank[k]);
+                msg.push_back(idx++);
+            }
+        }
+        t.exchange(outbox, inbox);
+
+        next.clear();
+        for (int p = 0; p < n; p++) {
+            for (size_t i = 0; i < inbox[p].size(); i += 4) {
+                int li = localIndex(inbox[p][i]);
+                int r = inbox[p][i + 2];
+                int e = inbox[p][i + 3];
+                if (level[li] == -1) {
+                    level[li] = depth;
+                    next.push_back(li);
+                } else if (level[li] != depth || make_pair(r, e) >= make_pair(bestRank[li], bestEdge[li])) {
+                    continue;
+                }
+                parent[li] = inbox[p][i + 1];
+                bestRank[li] = r;
+                bestEdge[li] = e;
+            }
+        }
+
+        /* Send found flag and rank keys to worker 0 */
+        bool found = owner(search_id) == me && search_id >= 0 && search_id < total &&
+                     level[localIndex(search_id)] == depth;
+        outbox[0].push_back(found ? 1 : 0);
+        for (int li : next) {
+            outbox[0].push_back(bestRank[li]);
+            outbox[0].push_back(bestEdge[li]);
+        }
+        t.exchange(outbox, inbox);
+
+        if (me == 0) {
+            vector<tuple<int, int, int, int>> keys; // parent rank, edge index, worker, position
+            bool anyFound = false;
+            for (int p = 0; p < n; p++) {
+                anyFound = anyFound || inbox[p][0] == 1;
+                for (size_t i = 1; i < inbox[p].size(); i += 2) {
+                    keys.push_back(make_tuple(inbox[p][i], inbox[p][i + 1], p, (i - 1) / 2));
+                }
+            }
+            int s = anyFound ? BFS_FOUND : keys.empty() ? BFS_EXHAUSTED : BFS_CONTINUE;
+            for (int p = 0; p < n; p++) {
+                outbox[p].push_back(s);
+                outbox[p].resize(1 + (inbox[p].size() - 1) / 2);
+            }
+            if (s == BFS_CONTINUE) {
+                sort(keys.begin(), keys.end());
+                for (size_t r = 0; r < keys.size(); r++) {
+                    outbox[get<2>(keys[r])][1 + get<3>(keys[r])] = r;
+                }
+            }
+        }
+        t.exchange(outbox, inbox);
+
+        status = inbox[0][0];
+        frontier.swap(next);
+        frontierRank.assign(inbox[0].begin() + 1, inbox[0].end());
+    }
+
+    if (status == BFS_EXHAUSTED) {
+        return vector<int>(1, -1);
+    }
+
+    /* Walk parents back from search_id, the owner of each step tells everyone */
+    vector<int> path(1, search_id);
+    int cur = search_id;
+    while (cur != start_id) {
+        if (owner(cur) == me) {
+            for (int p = 0; p < n; p++) {
+                outbox[p].push_back(parent[localIndex(cur)]);
+            }
+        }
+        t.exchange(outbox, inbox);
+        cur = inbox[owner(cur)][0];
+        path.push_back(cur);
+    }
+    reverse(path.begin(), path.end());
+    return path;
+}
+
+int PartitionedGraph::trim(vector<int>& comp) {
+    const int n = t.size();
+    vector<int> inDeg(numOwned, 0), outDeg(numOwned, 0);
+    vector<char> queued(numOwned, 0);
+
+    /* Count edges between unassigned vertices: tell each endpoint about the other */
+    for (int li = 0; li < numOwned; li++) {
+        if (comp[li] == -1) {
+            for (int v : out[li]) {
+                outbox[owner(v)].push_back(v);
+                outbox[owner(v)].push_back(0); // v gains an in edge
+            }
+            for (int v : in[li]) {
+                outbox[owner(v)].push_back(v);
+                outbox[owner(v)].push_back(1); // v gains an out edge
+            }
+        }
+    }
+    t.exchange(outbox, inbox);
+    for (int p = 0; p < n; p++) {
+        for (size_t i = 0; i < inbox[p].size(); i += 2) {
+            int li = localIndex(inbox[p][i]);
+            (inbox[p][i + 1] == 0 ? inDeg[li] : outDeg[li])++;
+        }
+    }
+
+    vector<int> queue;
+    for (int li = 0; li < numOwned; li++) {
+        if (comp[li] == -1 && (inDeg[li] == 0 || outDeg[li] == 0)) {
+            queue.push_back(li);
+            queued[li] = 1;
+        }
+    }
+
+    int removed = 0;
+    while (sumAll(queue.size()) > 0) {
+        for (int li : queue) {
+            comp[li] = globalId(li);
+            removed++;
+            for (int v : out[li]) {
+                outbox[owner(v)].push_back(v);
+                outbox[owner(v)].push_back(0);
+            }
+            for (int v : in[li]) {
+                outbox[owner(v)].push_back(v);
+                outbox[owner(v)].push_back(1);
+            }
+        }
+        t.exchange(outbox, inbox);
+
+        queue.clear();
+        for (int p = 0; p < n; p++) {
+            for (size_t i = 0; i < inbox[p].size(); i += 2) {
+                int li = localIndex(inbox[p][i]);
+                if (comp[li] != -1) {
+                    continue;
+                }
+                int deg = --(inbox[p][i + 1] == 0 ? inDeg[li] : outDeg[li]);
+                if (deg == 0 && !queued[li]) {
+                    queue.push_back(li);
+                    queued[li] = 1;
+                }
+            }
+        }
+    }
+    return removed;
+}
+
+/*
+ *  Each round: trim, spread the largest id forward through the unassigned
+ *  vertices, then every vertex that kept its own id collects the vertices of
+ *  its color that reach it backward. Those form its component.
+ */
+unordered_map<int, list<int>> PartitionedGraph::SCC() {
+    const int n = t.size();
+    vector<int> comp(numOwned, -1);
+    vector<int> color(numOwned);
+    vector<int> changed, frontier;
+    vector<char> inChanged(numOwned, 0);
+
+    int unassigned = numOwned;
+    while (sumAll(unassigned) > 0) {
+        trim(comp);
+
+        /* Forward: color = largest id that reaches the vertex */
+        changed.clear();
+        for (int li = 0; li < numOwned; li++) {
+            if (comp[li] == -1) {
+                color[li] = globalId(li);
+                changed.push_back(li);
+            }
+        }
+        while (sumAll(changed.size()) > 0) {
+            for (int li : changed) {
+                inChanged[li] = 0;
+                for (int v : out[li]) {
+                    outbox[owner(v)].push_back(v);
+                    outbox[owner(v)].push_back(color[li]);
+                }
+            }
+            t.exchange(outbox, inbox);
+
+            changed.clear();
+            for (int p = 0; p < n; p++) {
+                for (size_t i = 0; i < inbox[p].size(); i += 2) {
+                    int li = localIndex(inbox[p][i]);
+                    if (comp[li] == -1 && inbox[p][i + 1] > color[li]) {
+                        color[li] = inbox[p][i + 1];
+                        if (!inChanged[li]) {
+                            changed.push_back(li);
+                            inChanged[li] = 1;
+                        }
+                    }
+                }
+            }
+        }
+
+        /* Backward: from each root, over in edges, within its color */
+        frontier.clear();
+        for (int li = 0; li < numOwned; li++) {
+            if (comp[li] == -1 && color[li] == globalId(li)) {
+                comp[li] = color[li];
+                frontier.push_back(li);
+            }
+        }
+        while (sumAll(frontier.size()) > 0) {
+            for (int li : frontier) {
+                for (int v : in[li]) {
+                    outbox[owner(v)].push_back(v);
+                    outbox[owner(v)].push_back(comp[li]);
+                }
+            }
+            t.exchange(outbox, inbox);
+
+            frontier.clear();
+            for (int p = 0; p < n; p++) {
+                for (size_t i = 0; i < inbox[p].size(); i += 2) {
+                    int li = localIndex(inbox[p][i]);
+                    if (comp[li] == -1 && color[li] == inbox[p][i + 1]) {
+                        comp[li] = color[li];
+                        frontier.push_back(li);
+                    }
+                }
+            }
+        }
+
+        unassigned = count(comp.begin(), comp.end(), -1);
+    }
+
+    /* Gather (vertex, component) pairs on worker 0 */
+    for (int li = 0; li < numOwned; li++) {
+        outbox[0].push_back(globalId(li));
+        outbox[0].push_back(comp[li]);
+    }
+    t.exchange(outbox, inbox);
+
+    unordered_map<int, list<int>> return_map;
+    if (t.rank() == 0) {
+        for (int p = 0; p < n; p++) {
+            for (size_t i = 0; i < inbox[p].size(); i += 2) {
+                return_map[inbox[p][i + 1]].push_back(inbox[p][i]);
+            }
+        }
+    }
+    return return_map;
+}
+
+Cluster::Cluster(int workers, Partitioning part, string vertexFile, string edgeFile) {
+    if (workers < 1) {
+        workers = 1;
+    }
+    vector<vector<int>> mesh = SocketTransport::createMesh(workers);
+
+    std::cout.flush(); // don't let the children inherit unflushed output
+    std::cerr.flush();
+    for (int r = 0; r < workers; r++) {
+        int control[2];
+        if (socketpair(AF_UNIX, SOCK_STREAM, 0, control) != 0) {
+            std::cout << "Could not create control socket" << std::endl;
+            abort();
+        }
+        pid_t pid = fork();
+        if (pid == 0) {
+            close(control[0]);
+            for (int fd : controls) {
+                close(fd);
+            }
+            serve(r, mesh, control[1], part, vertexFile, edgeFile);
+        }
+        close(control[1]);
+        controls.push_back(control[0]);
+        pids.push_back(pid);
+    }
+
+    /* Only the workers talk over the mesh */
+    for (vector<int>& row : mesh) {
+        for (int fd : row) {
+            if (fd != -1) {
+                close(fd);
+            }
+        }
+    }
+}
+
+Cluster::~Cluster() {
+    broadcast(vector<int>(1, CMD_QUIT));
+    for (int fd : controls) {
+        close(fd);
+    }
+    for (pid_t pid : pids) {
+        waitpid(pid, NULL, 0);
+    }
+}
+
+void Cluster::broadcast(const vector<int>& cmd) {
+    for (int fd : controls) {
+        sendMessage(fd, cmd);
+    }
+}
+
+vector<int> Cluster::BFS(int search_id, int start_id) {
+    vector<int> cmd;
+    cmd.push_back(CMD_BFS);
+    cmd.push_back(search_id);
+    cmd.push_back(start_id);
+    broadcast(cmd);
+
+    vector<int> path;
+    recvMessage(controls[0], path);
+    return path;
+}
+
+unordered_map<int, list<int>> Cluster::SCC() {
+    broadcast(vector<int>(1, CMD_SCC));
+
+    /* Flattened as root, size, members..., root, size, ... */
+    vector<int> flat;
+    recvMessage(controls[0], flat);
+    unordered_map<int, list<int>> return_map;
+    for (size_t i = 0; i < flat.size(); i += 2 + flat[i + 1]) {
+        return_map[flat[i]] = list<int>(flat.begin() + i + 2, flat.begin() + i + 2 + flat[i + 1]);
+    }
+    return return_map;
+}
+
+void Cluster::serve(int rank, vector<vector<int>>& mesh, int control, Partitioning part,
+                    string vertexFile, string edgeFile) {
+    {
+        SocketTransport transport(rank, mesh);
+        PartitionedGraph g(transport, part, vertexFile, edgeFile);
+
+        vector<int> cmd;
+        while (recvMessage(control, cmd) && !cmd.empty() && cmd[0] != CMD_QUIT) {
+            if (cmd[0] == CMD_BFS) {
+                vector<int> path = g.BFS(cmd[1], cmd[2]);
+                if (rank == 0) {
+                    sendMessage(control, path);
+                }
+            } else if (cmd[0] == CMD_SCC) {
+                unordered_map<int, list<int>> components = g.SCC();
+                if (rank == 0) {
+                    vector<int> flat;
+                    for (std::pair<const int, list<int>>& c : components) {
+                        flat.push_back(c.first);
+                        flat.push_back(c.second.size());
+                        flat.insert(flat.end(), c.second.begin(), c.second.end());
+                    }
+                    sendMessage(control, flat);
+                }
+            }
+        }
+        close(control);
+    }
+    _exit(0); // skip the parent's atexit handlers and stdio buffers
+}
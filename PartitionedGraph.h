@@ -0,0 +1,95 @@
+#pragma once
+#include "Transport.h"
+#include <vector>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <sys/types.h>
+
+/*
+ * How vertex ids are spread over the workers
+ * RANGE  - worker i owns one contiguous block of ids
+ * MODULO - worker i owns every id with id % workers == i
+ */
+enum class Partitioning { RANGE, MODULO };
+
+/*
+ * One worker's share of the link graph. Holds the out and in edges of the
+ * vertices it owns (no names or categories), and runs the distributed
+ * algorithms together with the other workers over a Transport.
+ * Every algorithm is collective: all workers must call it with the same
+ * arguments.
+ */
+class PartitionedGraph {
+    public:
+        /*
+         * Scans both files and keeps only the edges touching owned vertices
+         */
+        PartitionedGraph(Transport& transport, Partitioning part, std::string vertexFile, std::string edgeFile);
+
+        /*
+         * Same path as Graph::BFS, {-1} if search_id can't be reached.
+         * Level synchronous; a vertex reached from several workers in one level
+         * keeps the parent the sequential BFS would have dequeued first
+         */
+        std::vector<int> BFS(int search_id, int start_id = 0);
+
+        /*
+         * Strongly connected components by trimming plus forward/backward
+         * coloring. Each component is keyed by its largest vertex id. The
+         * full map is only returned on worker 0, the others get an empty map
+         */
+        std::unordered_map<int, std::list<int>> SCC();
+
+        int owner(int v) const;
+        int numVertices() const { return total; }
+
+    private:
+        int localIndex(int v) const;
+        int globalId(int i) const;
+
+        /*
+         * Sums x over all workers
+         */
+        int sumAll(int x);
+
+        /*
+         * Removes unassigned vertices with no unassigned in or out edges,
+         * each becomes its own component. Returns how many were removed
+         */
+        int trim(std::vector<int>& comp);
+
+        Transport& t;
+        Partitioning part;
+        int total;       // vertices in the whole graph
+        int numOwned;
+        int rangeStart;  // first owned id for RANGE
+        std::vector<std::vector<int>> out; // out neighbors of each owned vertex, by local index
+        std::vector<std::vector<int>> in;  // in neighbors of each owned vertex, by local index
+        std::vector<std::vector<int>> outbox, inbox;
+};
+
+/*
+ * Runs a PartitionedGraph across worker processes forked from this one,
+ * and forwards queries to them. Worker 0 sends results back.
+ */
+class Cluster {
+    public:
+        Cluster(int workers, Partitioning part, std::string vertexFile, std::string edgeFile);
+        ~Cluster();
+
+        std::vector<int> BFS(int search_id, int start_id = 0);
+        std::unordered_map<int, std::list<int>> SCC();
+
+    private:
+        /*
+         * Worker process main loop, never returns
+         */
+        static void serve(int rank, std::vector<std::vector<int>>& mesh, int control, Partitioning part,
+                          std::string vertexFile, std::string edgeFile);
+
+        void broadcast(const std::vector<int>& cmd);
+
+        std::vector<int> controls; // parent's end of each worker's control socket
+        std::vector<pid_t> pids;
+};
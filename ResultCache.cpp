@@ -0,0 +1,193 @@
+#include "ResultCache.h"
+#include <algorithm>
+using namespace std;
+
+bool QueryKey::operator==(const QueryKey& k) const {
+    return type == k.type && source == k.source && target == k.target && constraint == k.constraint;
+}
+
+size_t QueryKeyHash::operator()(const QueryKey& k) const {
+    size_t h = hash<int>()(k.source);
+    h = h * 31 + hash<int>()(k.target);
+    h = h * 31 + hash<int>()(k.constraint);
+    return h * 31 + static_cast<size_t>(k.type);
+}
+
+ResultCache::ResultCache(size_t capacity, unsigned numShards, unsigned hotThreshold, unsigned treeCapacity,
+                         unsigned missSlots)
+    : shards(numShards == 0 ? 1 : numShards), hotThreshold(min(max(hotThreshold, 1u), 255u)),
+      missSlots(missSlots == 0 ? 1 : missSlots), treeCapacity(treeCapacity),
+      hitCt(0), missCt(0), treeHitCt(0), evictCt(0) {
+    shardCapacity = capacity / shards.size();
+    for (Shard& s : shards) {
+        s.missCounts.assign(2 * this->missSlots, 0);
+    }
+}
+
+/*
+ *  All queries from one source land in the same shard, so the per-source
+ *  miss counts live next to that source's entries
+ */
+ResultCache::Shard& ResultCache::shardFor(int source) {
+    return shards[hash<int>()(source) % shards.size()];
+}
+
+bool ResultCache::lookup(const QueryKey& key, unsigned long version, vector<int>& out) {
+    Shard& s = shardFor(key.source);
+    lock_guard<mutex> guard(s.lock);
+
+    auto f = s.index.find(key);
+    if (f == s.index.end()) {
+        missCt++;
+        return false;
+    }
+    list<Entry>::iterator it = f->second;
+    if (it->version != version) { // computed against an older graph, drop it
+        s.used -= it->result.size() + 1;
+        s.lru.erase(it);
+        s.index.erase(f);
+        missCt++;
+        return false;
+    }
+    s.lru.splice(s.lru.begin(), s.lru, it); // move to front
+    out = it->result;
+    hitCt++;
+    return true;
+}
+
+void ResultCache::insert(const QueryKey& key, unsigned long version, const vector<int>& result) {
+    if (result.size() + 1 > shardCapacity) {
+        return; // would never fit
+    }
+    Shard& s = shardFor(key.source);
+    lock_guard<mutex> guard(s.lock);
+
+    auto f = s.index.find(key);
+    if (f != s.index.end()) {
+        s.used -= f->second->result.size() + 1;
+        s.lru.erase(f->second);
+        s.index.erase(f);
+    }
+
+    /* Evict from the back until the new result fits */
+    while (!s.lru.empty() && s.used + result.size() + 1 > shardCapacity) {
+        Entry& last = s.lru.back();
+        s.used -= last.result.size() + 1;
+        s.index.erase(last.key);
+        s.lru.pop_back();
+        evictCt++;
+    }
+
+    s.lru.push_front(Entry{key, version, result});
+    s.index[key] = s.lru.begin();
+    s.used += result.size() + 1;
+}
+
+bool ResultCache::lookupTree(int source, int target, unsigned long version, vector<int>& out) {
+    lock_guard<mutex> guard(treeLock);
+
+    for (list<Tree>::iterator it = trees.begin(); it != trees.end(); it++) {
+        if (it->source != source) {
+            continue;
+        }
+        if (it->version != version) {
+            trees.erase(it);
+            return false;
+        }
+        trees.splice(trees.begin(), trees, it);
+
+        out = pathFromTree(it->parents, source, target);
+        treeHitCt++;
+        return true;
+    }
+    return false;
+}
+
+bool ResultCache::noteMiss(int source) {
+    if (treeCapacity == 0) {
+        return false;
+    }
+    Shard& s = shardFor(source);
+    lock_guard<mutex> guard(s.lock);
+
+    /* Age every count once per missSlots misses, so the sketch never fills up */
+    if (++s.missesSinceDecay >= missSlots) {
+        for (unsigned char& c : s.missCounts) {
+            c /= 2;
+        }
+        s.missesSinceDecay = 0;
+    }
+
+    /* Count-min: two independently hashed counters, the smaller one is the estimate */
+    size_t h = hash<int>()(source);
+    unsigned char& a = s.missCounts[h % missSlots];
+    unsigned char& b = s.missCounts[missSlots + (h * 0x9E3779B97F4A7C15ULL >> 32) % missSlots];
+    if (a < 255) {
+        a++;
+    }
+    if (b < 255) {
+        b++;
+    }
+    if (min(a, b) >= hotThreshold) {
+        a = 0;
+        b = 0;
+        return true;
+    }
+    return false;
+}
+
+void ResultCache::insertTree(int source, unsigned long version, const vector<int>& parents) {
+    if (treeCapacity == 0) {
+        return;
+    }
+    lock_guard<mutex> guard(treeLock);
+
+    for (list<Tree>::iterator it = trees.begin(); it != trees.end(); it++) {
+        if (it->source == source) {
+            trees.erase(it);
+            break;
+        }
+    }
+    while (trees.size() >= treeCapacity) {
+        trees.pop_back();
+        evictCt++;
+    }
+    trees.push_front(Tree{source, version, parents});
+}
+
+void ResultCache::clear() {
+    for (Shard& s : shards) {
+        lock_guard<mutex> guard(s.lock);
+        s.lru.clear();
+        s.index.clear();
+        fill(s.missCounts.begin(), s.missCounts.end(), 0);
+        s.missesSinceDecay = 0;
+        s.used = 0;
+    }
+    lock_guard<mutex> guard(treeLock);
+    trees.clear();
+}
+
+vector<int> ResultCache::pathFromTree(const vector<int>& parents, int source, int target) {
+    /* Walk parents back from target to source */
+    vector<int> path;
+    if (target < 0 || target >= (int)parents.size() || parents[target] == -1) {
+        path.push_back(-1);
+        return path;
+    }
+    for (int v = target; v != source; v = parents[v]) {
+        path.push_back(v);
+    }
+    path.push_back(source);
+    reverse(path.begin(), path.end());
+    return path;
+}
+
+size_t ResultCache::size() {
+    size_t total = 0;
+    for (Shard& s : shards) {
+        lock_guard<mutex> guard(s.lock);
+        total += s.lru.size();
+    }
+    return total;
+}
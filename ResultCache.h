@@ -0,0 +1,140 @@
+#pragma once
+#include <vector>
+#include <list>
+#include <unordered_map>
+#include <mutex>
+#include <atomic>
+
+/*
+ * Kinds of query whose results can be cached
+ */
+enum class QueryType { PATH, CYCLE };
+
+/*
+ * Identifies one query: its type, source and target articles, and a
+ * constraint value (e.g. a depth limit, 0 when unused)
+ */
+struct QueryKey {
+    QueryType type;
+    int source;
+    int target;
+    int constraint;
+
+    bool operator==(const QueryKey& k) const;
+};
+
+struct QueryKeyHash {
+    size_t operator()(const QueryKey& k) const;
+};
+
+/*
+ * Concurrent, sharded LRU cache for BFS path and cycle results.
+ * Every entry is tagged with the graph version it was computed against;
+ * an entry from an older version counts as a miss and is dropped.
+ * Memory is bounded by the total number of vertex ids stored per shard
+ * (each entry costs its length plus one, so empty results count too).
+ *
+ * Sources that miss often enough become "hot" and get their whole BFS
+ * tree (parent array) cached, so any target from that source is answered
+ * by walking parents, in O(path length).
+ */
+class ResultCache {
+    public:
+        /*
+         * capacity     - max vertex ids stored across all path/cycle entries
+         * numShards    - number of independently locked shards
+         * hotThreshold - misses from one source before its BFS tree is cached
+         * treeCapacity - max number of BFS trees kept at once
+         * missSlots    - miss counters per shard for spotting hot sources,
+         *                a fixed 2 * missSlots bytes per shard
+         */
+        ResultCache(size_t capacity = 1 << 20, unsigned numShards = 16,
+                    unsigned hotThreshold = 3, unsigned treeCapacity = 4, unsigned missSlots = 4096);
+
+        /*
+         * Looks up key, copying the cached result into out on a hit
+         */
+        bool lookup(const QueryKey& key, unsigned long version, std::vector<int>& out);
+
+        /*
+         * Stores result for key, evicting least recently used entries of
+         * the shard until it fits in the shard's budget
+         */
+        void insert(const QueryKey& key, unsigned long version, const std::vector<int>& result);
+
+        /*
+         * Answers a source -> target path from a cached BFS tree, if one exists
+         * for source. Unreachable targets give {-1}, same as Graph::BFS
+         */
+        bool lookupTree(int source, int target, unsigned long version, std::vector<int>& out);
+
+        /*
+         * Records a miss from source, returns true once source is hot and
+         * should have its BFS tree computed and passed to insertTree.
+         * Counts live in a small count-min sketch that is halved every
+         * missSlots misses, so rarely queried sources fade out and a
+         * collision can at worst make a source hot a little early
+         */
+        bool noteMiss(int source);
+
+        /*
+         * Stores the BFS parent array for source (parents[source] == source,
+         * -1 for unreached vertices)
+         */
+        void insertTree(int source, unsigned long version, const std::vector<int>& parents);
+
+        /*
+         * Path from source to target in a BFS parent array, {-1} if target
+         * was not reached. Does not touch the cache or its counters
+         */
+        static std::vector<int> pathFromTree(const std::vector<int>& parents, int source, int target);
+
+        /*
+         * Drops every entry and tree
+         */
+        void clear();
+
+        unsigned long hits() const { return hitCt; }
+        unsigned long misses() const { return missCt; }
+        unsigned long treeHits() const { return treeHitCt; }
+        unsigned long evictions() const { return evictCt; }
+        size_t size();
+
+    private:
+        struct Entry {
+            QueryKey key;
+            unsigned long version;
+            std::vector<int> result;
+        };
+
+        struct Shard {
+            std::mutex lock;
+            std::list<Entry> lru; // most recently used at the front
+            std::unordered_map<QueryKey, std::list<Entry>::iterator, QueryKeyHash> index;
+            std::vector<unsigned char> missCounts; // two rows of missSlots counters
+            unsigned missesSinceDecay = 0;
+            size_t used = 0;
+        };
+
+        struct Tree {
+            int source;
+            unsigned long version;
+            std::vector<int> parents;
+        };
+
+        Shard& shardFor(int source);
+
+        std::vector<Shard> shards;
+        size_t shardCapacity;
+        unsigned hotThreshold;
+        unsigned missSlots;
+
+        std::mutex treeLock;
+        std::list<Tree> trees; // most recently used at the front
+        unsigned treeCapacity;
+
+        std::atomic<unsigned long> hitCt;
+        std::atomic<unsigned long> missCt;
+        std::atomic<unsigned long> treeHitCt;
+        std::atomic<unsigned long> evictCt;
+};
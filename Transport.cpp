@@ -0,0 +1,206 @@
+#include "Transport.h"
+#include <iostream>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+#include <cstdint>
+#include <poll.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/socket.h>
+using namespace std;
+
+vector<vector<int>> SocketTransport::createMesh(int n) {
+    vector<vector<int>> fds(n, vector<int>(n, -1));
+    for (int i = 0; i < n; i++) {
+        for (int j = i + 1; j < n; j++) {
+            int pair[2];
+            if (socketpair(AF_UNIX, SOCK_STREAM, 0, pair) != 0) {
+                std::cout << "Could not create worker sockets: " << strerror(errno) << std::endl;
+                abort();
+            }
+            fds[i][j] = pair[0];
+            fds[j][i] = pair[1];
+        }
+    }
+    return fds;
+}
+
+SocketTransport::SocketTransport(int r, vector<vector<int>>& mesh) : me(r) {
+    for (int i = 0; i < (int)mesh.size(); i++) {
+        for (int j = 0; j < (int)mesh.size(); j++) {
+            if (i != r && mesh[i][j] != -1) {
+                close(mesh[i][j]);
+            }
+        }
+    }
+    peers = mesh[r];
+
+    /* Non-blocking so a full socket buffer never stalls the whole exchange */
+    for (int fd : peers) {
+        if (fd != -1) {
+            fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+        }
+    }
+}
+
+SocketTransport::~SocketTransport() {
+    for (int fd : peers) {
+        if (fd != -1) {
+            close(fd);
+        }
+    }
+}
+
+/*
+ *  Each batch goes out as a 4 byte count followed by the ints. Sends and
+ *  receives are interleaved with poll(), since two workers sending each
+ *  other more than a socket buffer's worth would otherwise deadlock.
+ */
+void SocketTransport::exchange(vector<vector<int>>& outbox, vector<vector<int>>& inbox) {
+    const int n = peers.size();
+    outbox.resize(n);
+    inbox.resize(n);
+
+    vector<vector<char>> sendBuf(n);
+    vector<size_t> sent(n, 0);
+    vector<uint32_t> header(n, 0);
+    vector<size_t> headerRead(n, 0);
+    vector<size_t> bodyRead(n, 0);
+
+    for (int p = 0; p < n; p++) {
+        inbox[p].clear();
+        if (p == me) {
+            inbox[p].swap(outbox[p]);
+            continue;
+        }
+        uint32_t count = outbox[p].size();
+        sendBuf[p].resize(sizeof(count) + count * sizeof(int));
+        memcpy(sendBuf[p].data(), &count, sizeof(count));
+        if (count > 0) {
+            memcpy(sendBuf[p].data() + sizeof(count), outbox[p].data(), count * sizeof(int));
+        }
+        outbox[p].clear();
+    }
+
+    int pending = 2 * (n - 1); // one send and one receive per peer
+    vector<pollfd> fds;
+    vector<int> who;
+    while (pending > 0) {
+        fds.clear();
+        who.clear();
+        for (int p = 0; p < n; p++) {
+            if (p == me) {
+                continue;
+            }
+            short events = 0;
+            if (sent[p] < sendBuf[p].size()) {
+                events |= POLLOUT;
+            }
+            bool bodyDone = headerRead[p] == sizeof(uint32_t) && bodyRead[p] == header[p] * sizeof(int);
+            if (!bodyDone) {
+                events |= POLLIN;
+            }
+            if (events != 0) {
+                fds.push_back(pollfd{peers[p], events, 0});
+                who.push_back(p);
+            }
+        }
+        if (poll(fds.data(), fds.size(), -1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            std::cout << "Worker " << me << " poll failed: " << strerror(errno) << std::endl;
+            abort();
+        }
+
+        for (size_t i = 0; i < fds.size(); i++) {
+            int p = who[i];
+            if (fds[i].revents & POLLOUT) {
+                ssize_t w = write(peers[p], sendBuf[p].data() + sent[p], sendBuf[p].size() - sent[p]);
+                if (w > 0) {
+                    sent[p] += w;
+                    if (sent[p] == sendBuf[p].size()) {
+                        pending--;
+                    }
+                }
+            }
+            if (fds[i].revents & (POLLIN | POLLHUP | POLLERR)) {
+                ssize_t r;
+                if (headerRead[p] < sizeof(uint32_t)) {
+                    r = read(peers[p], (char*)&header[p] + headerRead[p], sizeof(uint32_t) - headerRead[p]);
+                    if (r > 0) {
+                        headerRead[p] += r;
+                        if (headerRead[p] == sizeof(uint32_t)) {
+                            inbox[p].resize(header[p]);
+                            if (header[p] == 0) {
+                                pending--;
+                            }
+                        }
+                    }
+                } else {
+                    size_t want = header[p] * sizeof(int);
+                    r = read(peers[p], (char*)inbox[p].data() + bodyRead[p], want - bodyRead[p]);
+                    if (r > 0) {
+                        bodyRead[p] += r;
+                        if (bodyRead[p] == want) {
+                            pending--;
+                        }
+                    }
+                }
+                if (r == 0) {
+                    std::cout << "Worker " << me << " lost connection to worker " << p << std::endl;
+                    abort();
+                }
+            }
+        }
+    }
+}
+
+/*
+ *  Loops until the whole buffer is written/read, false if the other end closed
+ */
+static bool writeAll(int fd, const char* buf, size_t len) {
+    while (len > 0) {
+        ssize_t w = write(fd, buf, len);
+        if (w < 0 && errno == EINTR) {
+            continue;
+        }
+        if (w <= 0) {
+            return false;
+        }
+        buf += w;
+        len -= w;
+    }
+    return true;
+}
+
+static bool readAll(int fd, char* buf, size_t len) {
+    while (len > 0) {
+        ssize_t r = read(fd, buf, len);
+        if (r < 0 && errno == EINTR) {
+            continue;
+        }
+        if (r <= 0) {
+            return false;
+        }
+        buf += r;
+        len -= r;
+    }
+    return true;
+}
+
+bool sendMessage(int fd, const vector<int>& msg) {
+    uint32_t count = msg.size();
+    return writeAll(fd, (const char*)&count, sizeof(count)) &&
+           writeAll(fd, (const char*)msg.data(), count * sizeof(int));
+}
+
+bool recvMessage(int fd, vector<int>& msg) {
+    uint32_t count;
+    if (!readAll(fd, (char*)&count, sizeof(count))) {
+        return false;
+    }
+    msg.resize(count);
+    return readAll(fd, (char*)msg.data(), count * sizeof(int));
+}
@@ -0,0 +1,65 @@
+#pragma once
+#include <vector>
+
+/*
+ * Message passing between the worker processes of a partitioned graph.
+ * Workers run in lockstep supersteps: every worker calls exchange() once
+ * per superstep with one batch of ints for every worker (empty batches are
+ * fine), and gets back the batch each worker addressed to it.
+ */
+class Transport {
+    public:
+        virtual ~Transport() {}
+
+        /*
+         * This worker's number, 0 .. size() - 1
+         */
+        virtual int rank() const = 0;
+
+        /*
+         * Number of workers
+         */
+        virtual int size() const = 0;
+
+        /*
+         * outbox[p] is sent to worker p (outbox[rank()] is delivered to
+         * ourselves) and cleared. inbox[p] is replaced by what p sent us
+         */
+        virtual void exchange(std::vector<std::vector<int>>& outbox, std::vector<std::vector<int>>& inbox) = 0;
+};
+
+/*
+ * Transport over a full mesh of Unix domain socket pairs between
+ * processes on one machine. The mesh is created before forking and each
+ * worker keeps its own end of every pair.
+ */
+class SocketTransport : public Transport {
+    public:
+        /*
+         * Creates the sockets for n workers. fds[i][j] is worker i's end of
+         * the connection to worker j (-1 on the diagonal)
+         */
+        static std::vector<std::vector<int>> createMesh(int n);
+
+        /*
+         * Takes worker r's row of the mesh and closes every end that belongs
+         * to another worker
+         */
+        SocketTransport(int r, std::vector<std::vector<int>>& mesh);
+        ~SocketTransport();
+
+        int rank() const { return me; }
+        int size() const { return peers.size(); }
+        void exchange(std::vector<std::vector<int>>& outbox, std::vector<std::vector<int>>& inbox);
+
+    private:
+        int me;
+        std::vector<int> peers; // socket to each worker, -1 for ourselves
+};
+
+/*
+ * Blocking length-prefixed message helpers for a single socket, used for
+ * the control connection between the parent process and the workers
+ */
+bool sendMessage(int fd, const std::vector<int>& msg);
+bool recvMessage(int fd, std::vector<int>& msg);
@@ -1,8 +1,14 @@
 #include <fstream>
 #include <vector>
 #include <string>
+#include <set>
+#include <algorithm>
 #include "Graph.h"
 #include "Vertex.h"
+#include "Neighborhood.h"
+#include "PartitionedGraph.h"
+#include "ExternalGraph.h"
+#include "Betweenness.h"
 using namespace std;
 
 void userInputGraph(Graph* g);
@@ -13,20 +19,33 @@ void BFS(Graph* g);
 void cycleDetection(Graph* g);
 void landmark(Graph* g);
 void runKosaraju(Graph& g);
+void printCacheStats(Graph& g);
+int runExternal();
+void betweenness(Graph* g);
+void kHop(Graph* g);
+void egoNetwork(Graph* g);
+Direction readDirection();
+void distributed(Graph& g, string vertexFile, string edgeFile);
 void printHelp();
 bool fileExists(string filename);
 
-int main () {
+int main (int argc, char** argv) {
+    /* "./wiki_algs --external" works from disk for graphs that don't fit in memory */
+    if (argc > 1 && string(argv[1]) == "--external") {
+        return runExternal();
+    }
+
     Graph g;
     string input;
+    string vertexFile, edgeFile;
 
     cout << "Please enter the vertices file:" << std::endl;
-    cin >> input;
-    g.parseVertices(input);
+    cin >> vertexFile;
+    g.parseVertices(vertexFile);
 
     cout << "Please enter the edges file:" << std::endl;
-    cin >> input;
-    g.parseEdges(input);
+    cin >> edgeFile;
+    g.parseEdges(edgeFile);
 
     cout << "Please enter the categories file:" << std::endl;
     cin >> input;
@@ -60,6 +79,21 @@ int main () {
         else if(input == "scc"){
             runKosaraju(g);
         }
+        else if(input == "khop"){
+            kHop(&g);
+        }
+        else if(input == "ego"){
+            egoNetwork(&g);
+        }
+        else if(input == "dist"){
+            distributed(g, vertexFile, edgeFile);
+        }
+        else if(input == "bc"){
+            betweenness(&g);
+        }
+        else if(input == "cache"){
+            printCacheStats(g);
+        }
         else if(input == "help"){
             printHelp();
         }
@@ -183,6 +217,260 @@ void runKosaraju(Graph& g){
     std::cout << "# of strongly connected components: " << components.size() << std::endl;
 }
 
+Direction readDirection(){
+    string dir;
+    cout << "Direction (out/in/both): ";
+    cin >> dir;
+    if(dir == "in"){
+        return Direction::IN;
+    }
+    if(dir == "both"){
+        return Direction::BOTH;
+    }
+    return Direction::OUT;
+}
+
+void kHop(Graph* g){
+    int aid;
+    HopOptions opts;
+    cout << "\n   k-hop Neighbors\n";
+    cout << "====================\n";
+    cout << "ID of article: ";
+    cin >> aid;
+    cout << g->numToVertex[aid].name << "\n\n";
+    cout << "Number of hops: ";
+    cin >> opts.k;
+    opts.dir = readDirection();
+    cout << "Max neighbors per article (0 for no limit): ";
+    cin >> opts.fanout;
+    opts.sample = opts.fanout != 0;
+
+    Neighborhood n(*g);
+    vector<int> hood = n.kHop(aid, opts);
+    cout << "size of neighborhood: " << hood.size() << endl;
+    for (int v : hood) {
+        cout << v << " " << g->numToVertex[v].name << endl;
+    }
+    cout << "\n";
+}
+
+void egoNetwork(Graph* g){
+    int aid;
+    string filename;
+    HopOptions opts;
+    cout << "\n     Ego Network\n";
+    cout << "====================\n";
+    cout << "ID of article: ";
+    cin >> aid;
+    cout << g->numToVertex[aid].name << "\n\n";
+    cout << "Number of hops: ";
+    cin >> opts.k;
+    opts.dir = readDirection();
+    cout << "Output edge file: ";
+    cin >> filename;
+
+    /* Edges go straight to the file in the same "tail head" format as the input */
+    ofstream out(filename);
+    unsigned long edges = 0;
+    Neighborhood n(*g);
+    n.streamEgoNetwork(aid, opts, [&](int tail, int head) {
+        out << tail << " " << head << "\n";
+        edges++;
+    });
+    cout << "wrote " << edges << " edges to " << filename << "\n\n";
+}
+
+/*
+ *  Components as a set of sorted member lists, so results keyed by
+ *  different roots can be compared
+ */
+set<vector<int>> canonical(const unordered_map<int, list<int>>& components){
+    set<vector<int>> c;
+    for (const std::pair<const int, list<int>>& comp : components) {
+        vector<int> members(comp.second.begin(), comp.second.end());
+        sort(members.begin(), members.end());
+        c.insert(members);
+    }
+    return c;
+}
+
+void distributed(Graph& g, string vertexFile, string edgeFile){
+    int workers;
+    string part, query;
+    cout << "\n  Distributed Query\n";
+    cout << "====================\n";
+    cout << "Number of worker processes: ";
+    cin >> workers;
+    cout << "Partitioning (range/modulo): ";
+    cin >> part;
+    cout << "Query (bfs/scc): ";
+    cin >> query;
+
+    Cluster cluster(workers, part == "modulo" ? Partitioning::MODULO : Partitioning::RANGE, vertexFile, edgeFile);
+    if(query == "scc"){
+        unordered_map<int, list<int>> components = cluster.SCC();
+        std::cout << "# of strongly connected components: " << components.size() << std::endl;
+        bool same = canonical(components) == canonical(g.KosarajuSCC());
+        cout << "matches single process: " << (same ? "yes" : "no") << "\n\n";
+    }
+    else{
+        int aid, bid;
+        cout << "ID of first article: ";
+        cin >> aid;
+        cout << "ID of second article: ";
+        cin >> bid;
+        vector<int> path = cluster.BFS(bid, aid);
+        cout << "size of path: " << path.size() << endl;
+        cout << "\npath:\n";
+        for (int v : path) {
+            cout << v << " " << (v < 0 ? "" : g.numToVertex[v].name) << endl;
+        }
+        cout << "matches single process: " << (path == g.BFS(bid, aid) ? "yes" : "no") << "\n\n";
+    }
+}
+
+void betweenness(Graph* g){
+    string mode;
+    SampleOptions opts;
+    cout << "\n Betweenness Centrality\n";
+    cout << "====================\n";
+    cout << "Mode (exact/sampled): ";
+    cin >> mode;
+    cout << "Number of threads: ";
+    cin >> opts.threads;
+    cout << "Number of top articles to show: ";
+    cin >> opts.topK;
+
+    Betweenness bc(*g);
+    vector<double> scores;
+    if(mode == "exact"){
+        scores = bc.exact(opts.threads);
+    }
+    else{
+        do {
+            cout << "Error bound, greater than 0 (e.g. 0.05): ";
+            cin >> opts.epsilon;
+        } while (!(opts.epsilon > 0) && cin);
+        do {
+            cout << "Failure probability, between 0 and 1 (e.g. 0.1): ";
+            cin >> opts.delta;
+        } while (!(opts.delta > 0 && opts.delta < 1) && cin);
+        cout << "Adaptive stop constant (e.g. 5, 0 to always reach the error bound): ";
+        cin >> opts.adaptive;
+        scores = bc.sampled(opts);
+        if (bc.stoppedEarly()) {
+            cout << "stopped early after " << bc.samplesUsed() << " of " << bc.sampleBound()
+                 << " sources, the error bound is not guaranteed" << endl;
+        } else {
+            cout << "error bound " << opts.epsilon << " holds with probability " << 1 - opts.delta << endl;
+        }
+    }
+    cout << "sources used: " << bc.samplesUsed() << endl;
+    for (std::pair<int, double> p : Betweenness::topK(scores, opts.topK)) {
+        cout << p.first << " " << g->numToVertex[p.first].name << " " << p.second << endl;
+    }
+    cout << "\n";
+}
+
+void printCacheStats(Graph& g){
+    cout << "\n     Cache Stats\n";
+    cout << "====================\n";
+    cout << "graph version: " << g.version << endl;
+    cout << "entries: " << g.cache.size() << endl;
+    cout << "hits: " << g.cache.hits() << endl;
+    cout << "misses: " << g.cache.misses() << endl;
+    cout << "BFS tree hits: " << g.cache.treeHits() << endl;
+    cout << "evictions: " << g.cache.evictions() << endl;
+}
+
+/*
+ *  Looks up the names of the given ids with one pass over the vertex file
+ */
+unordered_map<int, string> namesOf(string vertexFile, const vector<int>& ids){
+    unordered_map<int, string> names;
+    for (int id : ids) {
+        names[id] = "";
+    }
+    ifstream fileVertex(vertexFile);
+    string line;
+    for (int i = 0; getline(fileVertex, line); i++) {
+        if (names.count(i)) {
+            names[i] = line.substr(line.find(" ") + 1);
+        }
+    }
+    return names;
+}
+
+int runExternal(){
+    string vertexFile, edgeFile, csrFile, input;
+    cout << "Please enter the vertices file:" << std::endl;
+    cin >> vertexFile;
+    cout << "Please enter the edges file:" << std::endl;
+    cin >> edgeFile;
+    cout << "Please enter the CSR file (built from the two above if it doesn't exist):" << std::endl;
+    cin >> csrFile;
+    if(!fileExists(csrFile)){
+        cout << "Building " << csrFile << "..." << endl;
+        ExternalGraph::buildCSR(vertexFile, edgeFile, csrFile);
+    }
+    ExternalGraph g(csrFile);
+    cout << g.numVertices() << " vertices, " << g.numEdges() << " edges on disk" << endl;
+
+    while(true){
+        cout << "What would you like to do next? (bfs, wcc, pr, q)" << endl;
+        cin >> input;
+        if(input == "bfs"){
+            int aid, bid;
+            cout << "ID of first article: ";
+            cin >> aid;
+            cout << "ID of second article: ";
+            cin >> bid;
+            vector<int> path = g.BFS(bid, aid);
+            unordered_map<int, string> names = namesOf(vertexFile, path);
+            cout << "size of path: " << path.size() << endl;
+            cout << "\npath:\n";
+            for (int v : path) {
+                cout << v << " " << names[v] << endl;
+            }
+            cout << "\n";
+        }
+        else if(input == "wcc"){
+            vector<int> comp = g.weakComponents();
+            int count = 0;
+            for (int v = 0; v < g.numVertices(); v++) {
+                if (comp[v] == v) {
+                    count++;
+                }
+            }
+            cout << "# of weakly connected components: " << count << "\n\n";
+        }
+        else if(input == "pr"){
+            vector<double> rank = g.pageRank();
+            vector<int> order(rank.size());
+            for (size_t v = 0; v < order.size(); v++) {
+                order[v] = v;
+            }
+            size_t top = min((size_t)10, order.size());
+            partial_sort(order.begin(), order.begin() + top, order.end(), [&](int a, int b) {
+                return rank[a] > rank[b];
+            });
+            order.resize(top);
+            unordered_map<int, string> names = namesOf(vertexFile, order);
+            cout << "top articles by PageRank:" << endl;
+            for (int v : order) {
+                cout << v << " " << names[v] << " " << rank[v] << endl;
+            }
+            cout << "\n";
+        }
+        else if(input == "end" || input == "q"){
+            return 0;
+        }
+        else{
+            cout << "input not recognized, please try again" << endl;
+        }
+    }
+}
+
 void printHelp(){
     cout << "pn - Print name" << endl;
     cout << "pN - Print neighbor" << endl;
@@ -191,6 +479,11 @@ void printHelp(){
     cout << "cd - Cycle detection" << endl;
     cout << "l - Landmark algorithm" << endl;
     cout << "scc - Strongly connected component enumeration" << endl;
+    cout << "khop - k-hop neighborhood of an article" << endl;
+    cout << "ego - Write an article's ego network to an edge file" << endl;
+    cout << "dist - Run BFS or SCC on partitioned worker processes" << endl;
+    cout << "bc - Betweenness centrality, exact or sampled" << endl;
+    cout << "cache - Print path/cycle cache stats" << endl;
     cout << "end/q - Terminate program" << endl;
     cout << "help - Display help" << endl;
 }